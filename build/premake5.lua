@@ -150,6 +150,15 @@ workspace (workspaceName)
         includedirs { "../src" }
         includedirs { "../include" }
 
+        -- route RL_MALLOC & co through the game allocator (src/game_memory.c)
+        forceincludes { "../src/rl_alloc_hooks.h" }
+
+        -- procgen row loops are written for the auto-vectorizer: gcc only vectorizes them at -O3,
+        -- and sqrtf keeps them scalar unless errno is dropped
+        filter { "files:../src/procgen.c", "action:gmake*" }
+            buildoptions { "-O3", "-fno-math-errno" }
+        filter{}
+
         links {"raylib"}
 
         includedirs {raylib_dir .. "/src" }
@@ -194,6 +203,9 @@ workspace (workspaceName)
         filter{}
 
         includedirs {raylib_dir .. "/src", raylib_dir .. "/src/external/glfw/include" }
+
+        -- must match the game project so raylib allocations are counted by GameMemAlloc()
+        forceincludes { "../src/rl_alloc_hooks.h" }
         vpaths
         {
             ["Header Files"] = { raylib_dir .. "/src/**.h"},
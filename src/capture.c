@@ -0,0 +1,398 @@
+#include "capture.h"
+#include "game_thread.h"
+#include "raylib.h"
+#include "rlgl.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(GRAPHICS_API_OPENGL_33) || defined(GRAPHICS_API_OPENGL_43)
+	#define CAPTURE_USE_PBO		 // pixel pack buffers need GL 2.1+, map range needs GL 3.0
+	#include "external/glad.h" // loaded by rlgl, the function pointers live in raylib's rcore
+#endif
+
+// msf_gif used to be compiled into rcore (SUPPORT_GIF_RECORDING), it now lives here
+#define MSF_GIF_MALLOC(contextPointer, newSize) RL_MALLOC(newSize)
+#define MSF_GIF_REALLOC(contextPointer, oldMemory, oldSize, newSize) RL_REALLOC(oldMemory, newSize)
+#define MSF_GIF_FREE(contextPointer, oldMemory, oldSize) RL_FREE(oldMemory)
+#define MSF_GIF_IMPL
+#include "external/msf_gif.h"
+
+#include "external/qoi.h" // implementation is compiled into raylib's rtextures
+
+typedef struct CaptureFrame
+{
+	unsigned char *pixels; // width*height RGBA8
+	int delayMs;		   // time since the previous queued frame, dropped frames included
+	int frameIndex;		   // position in the capture, gaps mean dropped frames
+	bool bottomUp;		   // straight from glReadPixels, rows need flipping
+} CaptureFrame;
+
+typedef struct CaptureState
+{
+	bool active;
+	CaptureFormat format;
+	int width;
+	int height;
+	char fileName[512]; // .gif/.rgba file, or the prefix for .qoi frames
+
+	// main thread
+	double lastTime; // GetTime() of the previous captured frame
+	float gifTimer;
+	int framesCaptured; // read back so far, dropped or not
+	int framesDropped;
+	int droppedDelayMs; // time covered by dropped frames, added to the next queued one
+#if defined(CAPTURE_USE_PBO)
+	unsigned int pbo[2];
+	int nextPbo;	  // buffer the next readback goes into
+	bool pboPending;  // the other buffer holds last frame's readback
+	int pendingDelayMs;
+	int pendingFrameIndex;
+#endif
+
+	// shared, guarded by mutex
+	CaptureFrame queue[CAPTURE_QUEUE_SIZE];
+	int queueHead;
+	int queueCount;
+	bool stopRequested;
+	GameMutex *mutex;
+	GameCond *frameReady; // worker waits for frames
+	GameCond *frameDone;  // flushing waits for a free slot
+	GameThread *worker;
+
+	// worker thread
+	MsfGifState gif;
+	int gifRemainderMs; // sub-centisecond time carried to the next GIF frame
+	FILE *rawFile;
+	unsigned char *flipBuffer; // QOI wants top-down rows
+	int framesWritten;
+} CaptureState;
+
+// Globals -------------------------------------------------------------
+static CaptureState capture = {0};
+static int captureCounter = 0;
+
+//------------------------------------------------------------------------------------
+// Encoder thread
+//------------------------------------------------------------------------------------
+
+static void EncodeFrame(CaptureFrame *frame)
+{
+	int pitch = capture.width * 4;
+
+	switch (capture.format)
+	{
+	case CAPTURE_GIF:
+	{
+		int elapsedMs = capture.gifRemainderMs + frame->delayMs;
+		msf_gif_frame(&capture.gif, frame->pixels, elapsedMs / 10, CAPTURE_GIF_BITDEPTH, frame->bottomUp ? -pitch : pitch);
+		capture.gifRemainderMs = elapsedMs % 10;
+	}
+	break;
+	case CAPTURE_QOI_SEQUENCE:
+	{
+		const unsigned char *pixels = frame->pixels;
+		if (frame->bottomUp)
+		{
+			for (int y = 0; y < capture.height; y++)
+				memcpy(capture.flipBuffer + y * pitch, frame->pixels + (capture.height - 1 - y) * pitch, pitch);
+			pixels = capture.flipBuffer;
+		}
+
+		int size = 0;
+		void *data = qoi_encode(pixels, &(qoi_desc){(unsigned int)capture.width, (unsigned int)capture.height, 4, QOI_SRGB}, &size);
+		if (data == NULL)
+			break;
+
+		// TextFormat() is not thread safe, the main thread uses it every frame
+		char fileName[600];
+		snprintf(fileName, sizeof(fileName), "%s_%05i.qoi", capture.fileName, frame->frameIndex);
+
+		FILE *file = fopen(fileName, "wb");
+		if (file != NULL)
+		{
+			fwrite(data, 1, (size_t)size, file);
+			fclose(file);
+		}
+		RL_FREE(data);
+	}
+	break;
+	case CAPTURE_RAW:
+	{
+		for (int y = 0; y < capture.height; y++)
+		{
+			int row = frame->bottomUp ? (capture.height - 1 - y) : y;
+			fwrite(frame->pixels + row * pitch, 1, (size_t)pitch, capture.rawFile);
+		}
+	}
+	break;
+	}
+
+	capture.framesWritten++;
+}
+
+static void CaptureWorker(void *userData)
+{
+	(void)userData;
+
+	for (;;)
+	{
+		GameMutexLock(capture.mutex);
+		while (capture.queueCount == 0 && !capture.stopRequested)
+			GameCondWait(capture.frameReady, capture.mutex);
+
+		if (capture.queueCount == 0) // stop requested and nothing left to encode
+		{
+			GameMutexUnlock(capture.mutex);
+			break;
+		}
+		CaptureFrame *frame = &capture.queue[capture.queueHead];
+		GameMutexUnlock(capture.mutex);
+
+		// the head slot stays ours until it is popped
+		EncodeFrame(frame);
+
+		GameMutexLock(capture.mutex);
+		capture.queueHead = (capture.queueHead + 1) % CAPTURE_QUEUE_SIZE;
+		capture.queueCount--;
+		GameCondSignal(capture.frameDone);
+		GameMutexUnlock(capture.mutex);
+	}
+}
+
+//------------------------------------------------------------------------------------
+// Main thread
+//------------------------------------------------------------------------------------
+
+// Copy a frame into the queue, dropping it when the encoder is behind (unless wait is set)
+// A dropped frame's time is carried over so GIF timing stays real time
+static void PushFrame(const unsigned char *pixels, int delayMs, int frameIndex, bool bottomUp, bool wait)
+{
+	GameMutexLock(capture.mutex);
+	while (wait && capture.queueCount == CAPTURE_QUEUE_SIZE)
+		GameCondWait(capture.frameDone, capture.mutex);
+
+	if (capture.queueCount == CAPTURE_QUEUE_SIZE)
+	{
+		GameMutexUnlock(capture.mutex);
+		capture.framesDropped++;
+		capture.droppedDelayMs += delayMs;
+		return;
+	}
+	// the worker never touches the slot past the tail, so fill it without holding the lock
+	CaptureFrame *frame = &capture.queue[(capture.queueHead + capture.queueCount) % CAPTURE_QUEUE_SIZE];
+	GameMutexUnlock(capture.mutex);
+
+	memcpy(frame->pixels, pixels, (size_t)capture.width * capture.height * 4);
+	frame->delayMs = delayMs + capture.droppedDelayMs;
+	frame->frameIndex = frameIndex;
+	frame->bottomUp = bottomUp;
+	capture.droppedDelayMs = 0;
+
+	GameMutexLock(capture.mutex);
+	capture.queueCount++;
+	GameCondSignal(capture.frameReady);
+	GameMutexUnlock(capture.mutex);
+}
+
+#if defined(CAPTURE_USE_PBO)
+// Map the buffer read back on an earlier frame and queue it
+static void CollectPendingFrame(bool wait)
+{
+	if (!capture.pboPending)
+		return;
+
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, capture.pbo[capture.nextPbo ^ 1]);
+	const unsigned char *pixels = (const unsigned char *)glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)capture.width * capture.height * 4, GL_MAP_READ_BIT);
+	if (pixels != NULL)
+	{
+		PushFrame(pixels, capture.pendingDelayMs, capture.pendingFrameIndex, true, wait);
+		glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	capture.pboPending = false;
+}
+#endif
+
+// Free whatever StartCapture() managed to set up
+static void ReleaseCapture(void)
+{
+#if defined(CAPTURE_USE_PBO)
+	if (capture.pbo[0] != 0)
+		glDeleteBuffers(2, capture.pbo);
+#endif
+	for (int i = 0; i < CAPTURE_QUEUE_SIZE; i++)
+		RL_FREE(capture.queue[i].pixels);
+	RL_FREE(capture.flipBuffer);
+
+	if (capture.rawFile != NULL)
+		fclose(capture.rawFile);
+
+	GameCondDestroy(capture.frameReady);
+	GameCondDestroy(capture.frameDone);
+	GameMutexDestroy(capture.mutex);
+
+	capture = (CaptureState){0};
+}
+
+bool StartCapture(CaptureFormat format)
+{
+	if (capture.active)
+		return false;
+
+	capture = (CaptureState){0};
+	capture.format = format;
+
+	// backbuffer size, same as raylib's own recorder
+#if defined(__APPLE__)
+	capture.width = GetRenderWidth(); // already DPI scaled on macOS
+	capture.height = GetRenderHeight();
+#else
+	Vector2 scale = GetWindowScaleDPI();
+	capture.width = (int)((float)GetRenderWidth() * scale.x);
+	capture.height = (int)((float)GetRenderHeight() * scale.y);
+#endif
+	size_t frameSize = (size_t)capture.width * capture.height * 4;
+
+	const char *directory = GetApplicationDirectory();
+	if (format == CAPTURE_GIF)
+		snprintf(capture.fileName, sizeof(capture.fileName), "%scapture%03i.gif", directory, captureCounter);
+	else if (format == CAPTURE_RAW)
+		snprintf(capture.fileName, sizeof(capture.fileName), "%scapture%03i_%ix%i.rgba", directory, captureCounter, capture.width, capture.height);
+	else
+		snprintf(capture.fileName, sizeof(capture.fileName), "%scapture%03i", directory, captureCounter);
+
+	bool ready = true;
+	for (int i = 0; i < CAPTURE_QUEUE_SIZE; i++)
+	{
+		capture.queue[i].pixels = (unsigned char *)RL_MALLOC(frameSize);
+		ready = ready && (capture.queue[i].pixels != NULL);
+	}
+
+	if (format == CAPTURE_GIF)
+		ready = ready && msf_gif_begin(&capture.gif, capture.width, capture.height);
+	else if (format == CAPTURE_QOI_SEQUENCE)
+		ready = ready && ((capture.flipBuffer = (unsigned char *)RL_MALLOC(frameSize)) != NULL);
+	else
+		ready = ready && ((capture.rawFile = fopen(capture.fileName, "wb")) != NULL);
+
+	capture.mutex = GameMutexCreate();
+	capture.frameReady = GameCondCreate();
+	capture.frameDone = GameCondCreate();
+	ready = ready && (capture.mutex != NULL) && (capture.frameReady != NULL) && (capture.frameDone != NULL);
+
+	if (ready)
+		capture.worker = GameThreadCreate(CaptureWorker, NULL);
+
+	if (capture.worker == NULL)
+	{
+		TraceLog(LOG_WARNING, "CAPTURE: Failed to start capture to %s", capture.fileName);
+		if (format == CAPTURE_GIF)
+			msf_gif_free(msf_gif_end(&capture.gif));
+		ReleaseCapture();
+		return false;
+	}
+
+#if defined(CAPTURE_USE_PBO)
+	glGenBuffers(2, capture.pbo);
+	for (int i = 0; i < 2; i++)
+	{
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, capture.pbo[i]);
+		glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)frameSize, NULL, GL_STREAM_READ);
+	}
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+#endif
+
+	capture.active = true;
+	TraceLog(LOG_INFO, "CAPTURE: Start recording %ix%i to %s", capture.width, capture.height, capture.fileName);
+	return true;
+}
+
+void StopCapture(void)
+{
+	if (!capture.active)
+		return;
+
+#if defined(CAPTURE_USE_PBO)
+	CollectPendingFrame(true); // the last frame is still sitting in a pixel pack buffer
+#endif
+
+	GameMutexLock(capture.mutex);
+	capture.stopRequested = true;
+	GameCondSignal(capture.frameReady);
+	GameMutexUnlock(capture.mutex);
+
+	GameThreadJoin(capture.worker); // encodes everything still queued
+	capture.worker = NULL;
+
+	if (capture.format == CAPTURE_GIF)
+	{
+		MsfGifResult result = msf_gif_end(&capture.gif);
+		SaveFileData(capture.fileName, result.data, (int)result.dataSize);
+		msf_gif_free(result);
+	}
+
+	TraceLog(LOG_INFO, "CAPTURE: Finish recording %s, %i frames written, %i dropped", capture.fileName, capture.framesWritten, capture.framesDropped);
+	if (capture.format == CAPTURE_RAW && capture.framesDropped > 0)
+		TraceLog(LOG_WARNING, "CAPTURE: Raw stream has no timestamps, with %i frames dropped it is not constant rate", capture.framesDropped);
+
+	ReleaseCapture();
+	captureCounter++;
+}
+
+void ToggleCapture(CaptureFormat format)
+{
+	if (capture.active)
+		StopCapture();
+	else
+		StartCapture(format);
+}
+
+bool IsCapturing(void)
+{
+	return capture.active;
+}
+
+void UpdateCapture(void)
+{
+	if (!capture.active)
+		return;
+
+	if (capture.format == CAPTURE_GIF)
+	{
+		// small tolerance so a 60 fps game lands on every second frame instead of drifting
+		const float period = 1.0f / CAPTURE_GIF_FRAMERATE;
+		capture.gifTimer += GetFrameTime();
+		if (capture.gifTimer < period - 0.002f)
+			return;
+		capture.gifTimer = (capture.gifTimer > 2 * period) ? 0.0f : capture.gifTimer - period;
+	}
+
+	int frameIndex = capture.framesCaptured++;
+	double now = GetTime();
+	int delayMs = (capture.lastTime > 0.0) ? (int)((now - capture.lastTime) * 1000.0) : 1000 / CAPTURE_GIF_FRAMERATE;
+	capture.lastTime = now;
+
+	rlDrawRenderBatchActive(); // flush pending draws into the backbuffer
+
+#if defined(CAPTURE_USE_PBO)
+	// queue this frame's copy, the GPU does it while we carry on
+	int current = capture.nextPbo;
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, capture.pbo[current]);
+	glReadPixels(0, 0, capture.width, capture.height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+	glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+	// ...and pick up last frame's copy, which has finished by now
+	CollectPendingFrame(false);
+
+	capture.pboPending = true;
+	capture.pendingDelayMs = delayMs;
+	capture.pendingFrameIndex = frameIndex;
+	capture.nextPbo = current ^ 1;
+#else
+	// no pixel pack buffers, synchronous readback but encoding still happens off the main thread
+	unsigned char *pixels = rlReadScreenPixels(capture.width, capture.height);
+	PushFrame(pixels, delayMs, frameIndex, false, false);
+	RL_FREE(pixels);
+#endif
+}
@@ -0,0 +1,29 @@
+// capture.h - screen capture to GIF / QOI frame sequence / raw RGBA video without stalling the frame loop
+//
+// Each captured frame is read back into one of two pixel pack buffers and only mapped a frame later,
+// when the GPU has finished the copy. Mapped pixels go into a bounded queue that a worker thread
+// encodes from. If the worker falls behind, frames are dropped instead of blocking the game.
+//
+// Replaces raylib's CTRL+F12 recorder (SUPPORT_GIF_RECORDING is disabled in raylib's config.h),
+// which read pixels and quantized the GIF inline in EndDrawing().
+
+#pragma once
+
+#include <stdbool.h>
+
+#define CAPTURE_QUEUE_SIZE 4	  // frames buffered between the game and the encoder thread
+#define CAPTURE_GIF_FRAMERATE 30  // GIF delays are in centiseconds, more than this just bloats the file
+#define CAPTURE_GIF_BITDEPTH 16	  // max colour bit depth for msf_gif quantization
+
+typedef enum CaptureFormat
+{
+	CAPTURE_GIF = 0,	  // capture000.gif
+	CAPTURE_QOI_SEQUENCE, // capture000_00000.qoi, capture000_00001.qoi, ... every frame, numbering skips dropped frames
+	CAPTURE_RAW			  // capture000_<w>x<h>.rgba, every frame appended as top-down RGBA8, constant rate only with no dropped frames
+} CaptureFormat;
+
+bool StartCapture(CaptureFormat format); // needs the GL context, files go next to the executable
+void StopCapture(void);					 // flushes queued frames and finishes the file
+void ToggleCapture(CaptureFormat format);
+bool IsCapturing(void);
+void UpdateCapture(void); // call once per frame after drawing the scene, before EndDrawing()
@@ -0,0 +1,296 @@
+#include "game_memory.h"
+#include "raylib.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+
+// Defines -------------------
+#define ARENA_ALIGNMENT 16
+#define MAX_ALLOC_SITES 512 // power of two, open addressed
+
+typedef struct AllocSite
+{
+	const char *file;
+	int line;
+	int count;	   // total calls since start
+	size_t bytes;  // total bytes since start
+	int frameCount; // calls in the frame being recorded
+	size_t frameBytes;
+	int lastFrameCount; // calls in the last completed frame
+	size_t lastFrameBytes;
+	int workerCount; // calls from other threads (audio, capture encoder, procgen helpers), not part of any frame
+	size_t workerBytes;
+} AllocSite;
+
+// Globals -------------------------------------------------------------
+MemArena frameArena = {0};
+MemArena levelArena = {0};
+
+static AllocSite allocSites[MAX_ALLOC_SITES] = {0};
+static int usedSites[MAX_ALLOC_SITES] = {0}; // indices into allocSites, in first-seen order
+static int usedSiteCount = 0;
+static int droppedSiteCalls = 0; // calls that found the site table full
+
+static MemFrameStats currentFrame = {0};
+static MemFrameStats lastFrame = {0};
+
+// Only the thread that called InitGameMemory() runs the frame loop, the rest are counted separately
+#if defined(_MSC_VER)
+static __declspec(thread) bool isMainThread = false;
+#else
+static __thread bool isMainThread = false;
+#endif
+
+// Stats are touched from the audio thread (miniaudio allocates through RL_MALLOC),
+// so everything below is guarded by a tiny spinlock
+#if defined(_MSC_VER)
+#include <intrin.h>
+static volatile long statsLock = 0;
+#define STATS_LOCK() while (_InterlockedExchange(&statsLock, 1)) {}
+#define STATS_UNLOCK() _InterlockedExchange(&statsLock, 0)
+#else
+static int statsLock = 0;
+#define STATS_LOCK() while (__atomic_exchange_n(&statsLock, 1, __ATOMIC_ACQUIRE)) {}
+#define STATS_UNLOCK() __atomic_store_n(&statsLock, 0, __ATOMIC_RELEASE)
+#endif
+
+//------------------------------------------------------------------------------------
+// Allocation hooks
+//------------------------------------------------------------------------------------
+
+// Find (or claim) the table slot for a call site - must hold statsLock
+static AllocSite *GetAllocSite(const char *file, int line)
+{
+	// __FILE__ is the same literal for a whole translation unit, so the pointer is a good enough key
+	unsigned int hash = (unsigned int)(((size_t)file >> 4) * 31u + (unsigned int)line) & (MAX_ALLOC_SITES - 1);
+
+	for (int probe = 0; probe < MAX_ALLOC_SITES; probe++)
+	{
+		AllocSite *site = &allocSites[(hash + probe) & (MAX_ALLOC_SITES - 1)];
+		if (site->file == NULL)
+		{
+			site->file = file;
+			site->line = line;
+			usedSites[usedSiteCount++] = (int)(site - allocSites);
+			return site;
+		}
+		if (site->line == line && site->file == file)
+			return site;
+	}
+
+	return NULL;
+}
+
+static void RecordAlloc(size_t size, const char *file, int line)
+{
+	STATS_LOCK();
+	if (isMainThread)
+	{
+		currentFrame.allocCount++;
+		currentFrame.allocBytes += size;
+	}
+
+	AllocSite *site = GetAllocSite(file, line);
+	if (site != NULL && isMainThread)
+	{
+		site->count++;
+		site->bytes += size;
+		site->frameCount++;
+		site->frameBytes += size;
+	}
+	else if (site != NULL)
+	{
+		site->workerCount++;
+		site->workerBytes += size;
+	}
+	else
+	{
+		droppedSiteCalls++;
+	}
+	STATS_UNLOCK();
+}
+
+void *GameMemAlloc(size_t size, const char *file, int line)
+{
+	RecordAlloc(size, file, line);
+	return malloc(size);
+}
+
+void *GameMemCalloc(size_t count, size_t size, const char *file, int line)
+{
+	RecordAlloc(count * size, file, line);
+	return calloc(count, size);
+}
+
+void *GameMemRealloc(void *ptr, size_t size, const char *file, int line)
+{
+	RecordAlloc(size, file, line);
+	return realloc(ptr, size);
+}
+
+void GameMemFree(void *ptr, const char *file, int line)
+{
+	(void)file;
+	(void)line;
+
+	if (ptr == NULL)
+		return;
+
+	if (isMainThread)
+	{
+		STATS_LOCK();
+		currentFrame.freeCount++;
+		STATS_UNLOCK();
+	}
+
+	free(ptr);
+}
+
+//------------------------------------------------------------------------------------
+// Arenas
+//------------------------------------------------------------------------------------
+
+void MemArenaInit(MemArena *arena, const char *name, size_t capacity)
+{
+	arena->name = name;
+	arena->base = (unsigned char *)RL_MALLOC(capacity);
+	arena->capacity = (arena->base != NULL) ? capacity : 0;
+	arena->offset = 0;
+	arena->peak = 0;
+
+	if (arena->base == NULL)
+		TraceLog(LOG_WARNING, "GAMEMEM: [%s] Failed to allocate %zu bytes", name, capacity);
+}
+
+void MemArenaFree(MemArena *arena)
+{
+	RL_FREE(arena->base);
+	*arena = (MemArena){0};
+}
+
+void MemArenaReset(MemArena *arena)
+{
+	arena->offset = 0;
+}
+
+void *MemArenaAlloc(MemArena *arena, size_t size)
+{
+	size_t start = (arena->offset + (ARENA_ALIGNMENT - 1)) & ~(size_t)(ARENA_ALIGNMENT - 1);
+
+	if (start > arena->capacity || size > arena->capacity - start)
+	{
+		TraceLog(LOG_WARNING, "GAMEMEM: [%s] Arena full, %zu bytes requested (%zu/%zu used)", arena->name, size, arena->offset, arena->capacity);
+		return NULL;
+	}
+
+	arena->offset = start + size;
+	if (arena->offset > arena->peak)
+		arena->peak = arena->offset;
+
+	return arena->base + start;
+}
+
+void *MemArenaAllocZero(MemArena *arena, size_t size)
+{
+	void *ptr = MemArenaAlloc(arena, size);
+	if (ptr != NULL)
+		memset(ptr, 0, size);
+	return ptr;
+}
+
+const char *MemArenaFormat(MemArena *arena, const char *text, ...)
+{
+	size_t start = (arena->offset + (ARENA_ALIGNMENT - 1)) & ~(size_t)(ARENA_ALIGNMENT - 1);
+	size_t available = (start < arena->capacity) ? arena->capacity - start : 0;
+
+	if (available == 0)
+		return "";
+
+	va_list args;
+	va_start(args, text);
+	int length = vsnprintf((char *)arena->base + start, available, text, args);
+	va_end(args);
+
+	if (length < 0 || (size_t)length >= available)
+	{
+		TraceLog(LOG_WARNING, "GAMEMEM: [%s] Arena full, formatted text truncated", arena->name);
+		return "";
+	}
+
+	// reserve exactly what vsnprintf wrote (plus terminator)
+	return (const char *)MemArenaAlloc(arena, (size_t)length + 1);
+}
+
+//------------------------------------------------------------------------------------
+// Game memory
+//------------------------------------------------------------------------------------
+
+void InitGameMemory(void)
+{
+	isMainThread = true;
+	MemArenaInit(&frameArena, "frame", FRAME_ARENA_SIZE);
+	MemArenaInit(&levelArena, "level", LEVEL_ARENA_SIZE);
+}
+
+void UnloadGameMemory(void)
+{
+	MemArenaFree(&frameArena);
+	MemArenaFree(&levelArena);
+}
+
+void GameMemoryEndFrame(void)
+{
+	MemArenaReset(&frameArena);
+
+	STATS_LOCK();
+	currentFrame.cleanFrames = (currentFrame.allocCount == 0) ? lastFrame.cleanFrames + 1 : 0;
+	lastFrame = currentFrame;
+	currentFrame = (MemFrameStats){0};
+
+	for (int i = 0; i < usedSiteCount; i++)
+	{
+		AllocSite *site = &allocSites[usedSites[i]];
+		site->lastFrameCount = site->frameCount;
+		site->lastFrameBytes = site->frameBytes;
+		site->frameCount = 0;
+		site->frameBytes = 0;
+	}
+	STATS_UNLOCK();
+}
+
+void GameMemoryResetLevel(void)
+{
+	MemArenaReset(&levelArena);
+}
+
+MemFrameStats GetGameMemoryFrameStats(void)
+{
+	STATS_LOCK();
+	MemFrameStats stats = lastFrame;
+	STATS_UNLOCK();
+	return stats;
+}
+
+void GameMemoryReport(void)
+{
+	TraceLog(LOG_INFO, "GAMEMEM: frame arena peak %zu/%zu bytes, level arena peak %zu/%zu bytes",
+			 frameArena.peak, frameArena.capacity, levelArena.peak, levelArena.capacity);
+
+	STATS_LOCK();
+	TraceLog(LOG_INFO, "GAMEMEM: last frame %d allocs (%zu bytes), %d frees, %d clean frames",
+			 lastFrame.allocCount, lastFrame.allocBytes, lastFrame.freeCount, lastFrame.cleanFrames);
+
+	for (int i = 0; i < usedSiteCount; i++)
+	{
+		const AllocSite *site = &allocSites[usedSites[i]];
+		const char *fileName = GetFileName(site->file); // raylib paths are long, keep the file name only
+
+		TraceLog(LOG_INFO, "GAMEMEM:     %s:%d - %d allocs (%zu bytes) total, %d allocs (%zu bytes) last frame, %d allocs (%zu bytes) off the main thread",
+				 fileName, site->line, site->count, site->bytes, site->lastFrameCount, site->lastFrameBytes, site->workerCount, site->workerBytes);
+	}
+
+	if (droppedSiteCalls > 0)
+		TraceLog(LOG_WARNING, "GAMEMEM: %d allocations not attributed, call site table full", droppedSiteCalls);
+	STATS_UNLOCK();
+}
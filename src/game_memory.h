@@ -0,0 +1,52 @@
+// game_memory.h - bump arenas and allocation stats for the game loop
+//
+// Two arenas live for the whole run:
+//   frameArena - scratch for one frame (formatted strings, draw lists), reset by GameMemoryEndFrame()
+//   levelArena - data for one round (spawned balls), reset by GameMemoryResetLevel() from InitGame()
+//
+// All raylib heap traffic goes through GameMemAlloc() (see rl_alloc_hooks.h), which counts
+// allocations per frame and per call site so the frame loop can be kept at zero heap allocations.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "rl_alloc_hooks.h"
+
+#define FRAME_ARENA_SIZE (256 * 1024)
+#define LEVEL_ARENA_SIZE (1024 * 1024)
+
+typedef struct MemArena
+{
+	const char *name;
+	unsigned char *base;
+	size_t capacity;
+	size_t offset;
+	size_t peak; // high-water mark across resets
+} MemArena;
+
+// Main thread only, allocations from other threads are reported per call site by GameMemoryReport()
+typedef struct MemFrameStats
+{
+	int allocCount;	  // malloc/calloc/realloc calls
+	size_t allocBytes; // bytes requested by those calls
+	int freeCount;
+	int cleanFrames; // consecutive frames with no heap allocations
+} MemFrameStats;
+
+extern MemArena frameArena;
+extern MemArena levelArena;
+
+void MemArenaInit(MemArena *arena, const char *name, size_t capacity);
+void MemArenaFree(MemArena *arena);
+void MemArenaReset(MemArena *arena);
+void *MemArenaAlloc(MemArena *arena, size_t size);	   // 16 byte aligned, NULL when the arena is full
+void *MemArenaAllocZero(MemArena *arena, size_t size); // same as above, zero filled
+const char *MemArenaFormat(MemArena *arena, const char *text, ...); // TextFormat() into the arena
+
+void InitGameMemory(void);	   // allocate the arenas and mark the calling thread as the frame loop - call before InitWindow()
+void UnloadGameMemory(void);
+void GameMemoryEndFrame(void);	 // reset frame arena and roll per-frame stats - call after EndDrawing()
+void GameMemoryResetLevel(void); // release everything in the level arena
+MemFrameStats GetGameMemoryFrameStats(void); // stats of the last completed frame
+void GameMemoryReport(void);	 // log totals and last frame counts per call site
@@ -0,0 +1,205 @@
+#include "game_thread.h"
+#include "rl_alloc_hooks.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+struct GameThread
+{
+	GameThreadFunc func;
+	void *userData;
+#if defined(_WIN32)
+	HANDLE handle;
+#else
+	pthread_t handle;
+#endif
+};
+
+struct GameMutex
+{
+#if defined(_WIN32)
+	CRITICAL_SECTION handle;
+#else
+	pthread_mutex_t handle;
+#endif
+};
+
+struct GameCond
+{
+#if defined(_WIN32)
+	CONDITION_VARIABLE handle;
+#else
+	pthread_cond_t handle;
+#endif
+};
+
+//------------------------------------------------------------------------------------
+// Threads
+//------------------------------------------------------------------------------------
+
+#if defined(_WIN32)
+static unsigned __stdcall ThreadEntry(void *arg)
+{
+	GameThread *thread = (GameThread *)arg;
+	thread->func(thread->userData);
+	return 0;
+}
+#else
+static void *ThreadEntry(void *arg)
+{
+	GameThread *thread = (GameThread *)arg;
+	thread->func(thread->userData);
+	return NULL;
+}
+#endif
+
+GameThread *GameThreadCreate(GameThreadFunc func, void *userData)
+{
+	GameThread *thread = (GameThread *)RL_MALLOC(sizeof(GameThread));
+	if (thread == NULL)
+		return NULL;
+
+	thread->func = func;
+	thread->userData = userData;
+
+#if defined(_WIN32)
+	thread->handle = (HANDLE)_beginthreadex(NULL, 0, ThreadEntry, thread, 0, NULL);
+	if (thread->handle == 0)
+#else
+	if (pthread_create(&thread->handle, NULL, ThreadEntry, thread) != 0)
+#endif
+	{
+		RL_FREE(thread);
+		return NULL;
+	}
+
+	return thread;
+}
+
+void GameThreadJoin(GameThread *thread)
+{
+	if (thread == NULL)
+		return;
+
+#if defined(_WIN32)
+	WaitForSingleObject(thread->handle, INFINITE);
+	CloseHandle(thread->handle);
+#else
+	pthread_join(thread->handle, NULL);
+#endif
+	RL_FREE(thread);
+}
+
+int GameThreadCpuCount(void)
+{
+#if defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	int count = (int)info.dwNumberOfProcessors;
+#else
+	int count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	return (count > 0) ? count : 1;
+}
+
+//------------------------------------------------------------------------------------
+// Mutexes
+//------------------------------------------------------------------------------------
+
+GameMutex *GameMutexCreate(void)
+{
+	GameMutex *mutex = (GameMutex *)RL_MALLOC(sizeof(GameMutex));
+	if (mutex == NULL)
+		return NULL;
+
+#if defined(_WIN32)
+	InitializeCriticalSection(&mutex->handle);
+#else
+	pthread_mutex_init(&mutex->handle, NULL);
+#endif
+	return mutex;
+}
+
+void GameMutexDestroy(GameMutex *mutex)
+{
+	if (mutex == NULL)
+		return;
+
+#if defined(_WIN32)
+	DeleteCriticalSection(&mutex->handle);
+#else
+	pthread_mutex_destroy(&mutex->handle);
+#endif
+	RL_FREE(mutex);
+}
+
+void GameMutexLock(GameMutex *mutex)
+{
+#if defined(_WIN32)
+	EnterCriticalSection(&mutex->handle);
+#else
+	pthread_mutex_lock(&mutex->handle);
+#endif
+}
+
+void GameMutexUnlock(GameMutex *mutex)
+{
+#if defined(_WIN32)
+	LeaveCriticalSection(&mutex->handle);
+#else
+	pthread_mutex_unlock(&mutex->handle);
+#endif
+}
+
+//------------------------------------------------------------------------------------
+// Condition variables
+//------------------------------------------------------------------------------------
+
+GameCond *GameCondCreate(void)
+{
+	GameCond *cond = (GameCond *)RL_MALLOC(sizeof(GameCond));
+	if (cond == NULL)
+		return NULL;
+
+#if defined(_WIN32)
+	InitializeConditionVariable(&cond->handle);
+#else
+	pthread_cond_init(&cond->handle, NULL);
+#endif
+	return cond;
+}
+
+void GameCondDestroy(GameCond *cond)
+{
+	if (cond == NULL)
+		return;
+
+#if !defined(_WIN32)
+	pthread_cond_destroy(&cond->handle);
+#endif
+	RL_FREE(cond);
+}
+
+void GameCondWait(GameCond *cond, GameMutex *mutex)
+{
+#if defined(_WIN32)
+	SleepConditionVariableCS(&cond->handle, &mutex->handle, INFINITE);
+#else
+	pthread_cond_wait(&cond->handle, &mutex->handle);
+#endif
+}
+
+void GameCondSignal(GameCond *cond)
+{
+#if defined(_WIN32)
+	WakeConditionVariable(&cond->handle);
+#else
+	pthread_cond_signal(&cond->handle);
+#endif
+}
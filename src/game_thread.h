@@ -0,0 +1,26 @@
+// game_thread.h - minimal thread, mutex and condition variable wrapper
+//
+// pthreads everywhere except MSVC/MinGW builds, which use the Win32 API. The Win32 path lives
+// in game_thread.c only, windows.h clashes with raylib.h (Rectangle, CloseWindow, DrawText...).
+
+#pragma once
+
+typedef struct GameThread GameThread;
+typedef struct GameMutex GameMutex;
+typedef struct GameCond GameCond;
+
+typedef void (*GameThreadFunc)(void *userData);
+
+GameThread *GameThreadCreate(GameThreadFunc func, void *userData); // NULL on failure
+void GameThreadJoin(GameThread *thread);							 // waits and frees the handle
+int GameThreadCpuCount(void);										 // logical processors, at least 1
+
+GameMutex *GameMutexCreate(void);
+void GameMutexDestroy(GameMutex *mutex);
+void GameMutexLock(GameMutex *mutex);
+void GameMutexUnlock(GameMutex *mutex);
+
+GameCond *GameCondCreate(void);
+void GameCondDestroy(GameCond *cond);
+void GameCondWait(GameCond *cond, GameMutex *mutex); // mutex must be locked
+void GameCondSignal(GameCond *cond);
@@ -3,15 +3,20 @@
 #include "stdio.h"
 #include <math.h>
 #include "resource_dir.h" // utility header for SearchAndSetResourceDir
+#include "game_memory.h"  // frame/level arenas and allocation stats
+#include "capture.h"      // GIF / frame sequence recording off the render thread
+#include "procgen.h"      // cached procedural level textures
 
 // Defines -------------------
 #define NUM_FRAMES_PER_LINE 3
 #define NUM_LINES 4
 #define MAX_BALLS 2
+#define MAX_SMALL_BALLS 100
 #define GRAVITY 0.1f
 #define VELOCITY 5
 #define ELASTICITY 0.95f
 #define BALL_SIZE 90
+#define NUM_LEVEL_THEMES 4
 
 typedef struct Sprite
 {
@@ -84,11 +89,24 @@ static Character projectile = {0};
 
 static Ball ball[MAX_BALLS] = {0};
 //static Ball sBall[(MAX_BALLS * 2)] = {0};
-static Ball sBall[100] = {0};
+static Ball *sBall = NULL; // MAX_SMALL_BALLS, allocated from the level arena in InitGame
 static int sBall_index = 0; // number of s balls
 
 static Shot shot = {0};
 
+// level look - regenerated (or loaded from the procgen cache) in InitGame
+static Texture2D background = {0};
+static Texture2D ballTexture = {0};
+static int level = 0;
+
+// width and height are filled in at load time
+static const ProcGenParams levelBackgrounds[NUM_LEVEL_THEMES] = {
+	{.type = PROCGEN_PERLIN, .colorA = {5, 5, 25, 255}, .colorB = {30, 90, 110, 255}, .seed = 1, .scale = 4.0f, .octaves = 6},
+	{.type = PROCGEN_GRADIENT_LINEAR, .colorA = {60, 10, 70, 255}, .colorB = {5, 5, 15, 255}, .direction = 90.0f},
+	{.type = PROCGEN_PERLIN, .colorA = {30, 5, 5, 255}, .colorB = {110, 60, 20, 255}, .seed = 3, .scale = 8.0f, .octaves = 5},
+	{.type = PROCGEN_GRADIENT_RADIAL, .colorA = {20, 50, 40, 255}, .colorB = {0, 0, 0, 255}, .scale = 0.1f},
+};
+
 static Wall wall_ceiling = {{0, 0, screenWidth, 15}, GRAY};
 static Wall wall_floor = {{0, 730, screenWidth, 60}, GRAY};
 static Wall wall_left = {{0, -1000, 15, screenHeight + 985}, GRAY};
@@ -97,6 +115,7 @@ static Wall wall_right = {{screenWidth - 15, -1000, 15, screenHeight + 985}, GRA
 bool gameOver = false;
 bool split = false;
 int split_clock = 0;
+bool showMemoryStats = false;
 
 //------------------------------------------------------------------------------------
 // Module Functions Declaration (local)
@@ -117,6 +136,7 @@ void UpdateProjectile(void);
 void CheckBallProjectileCollision(void);
 void initSprite(Character * character);
 void updateSprite(Character * character);
+void LoadLevelTextures(void);
 
 	int main()
 	{
@@ -133,6 +153,9 @@ void updateSprite(Character * character);
 
 	void InitEngine(void)
 	{
+		// Arenas first so raylib's own startup allocations are already counted against them
+		InitGameMemory();
+
 		// Tell the window to use vysnc and work on high DPI displays
 		SetConfigFlags(FLAG_VSYNC_HINT | FLAG_WINDOW_HIGHDPI);
 
@@ -155,6 +178,14 @@ void updateSprite(Character * character);
 	// Run each time on game over and reset
 	void InitGame(void)
 	{
+		// Drop everything the last round put in the level arena
+		GameMemoryResetLevel();
+		sBall = MemArenaAllocZero(&levelArena, MAX_SMALL_BALLS * sizeof(Ball));
+		sBall_index = 0;
+
+		LoadLevelTextures();
+		level++;
+
 		//---endWabbit ---------
 		endWabbit.position = (Vector2){60, 1000};
 
@@ -267,6 +298,25 @@ void updateSprite(Character * character);
 			// split ball hit into smaller ball.
 			// 1. just make the ball turn a different color - red.
 		}
+
+		if (IsKeyPressed('M')) // toggle heap allocation overlay
+		{
+			showMemoryStats = !showMemoryStats;
+		}
+
+		// screen recording - same key stops it
+		if (IsKeyPressed(KEY_F9))
+		{
+			ToggleCapture(CAPTURE_GIF);
+		}
+		if (IsKeyPressed(KEY_F10))
+		{
+			ToggleCapture(CAPTURE_QOI_SEQUENCE);
+		}
+		if (IsKeyPressed(KEY_F11))
+		{
+			ToggleCapture(CAPTURE_RAW);
+		}
 	}
 
 	void GameOverState()
@@ -341,7 +391,7 @@ void updateSprite(Character * character);
 	// put in a type of ball and then get a new one to add to the ball array
 	void CreateNewBall(Ball *ball, char type)
 	{
-		if (type == 's')
+		if (type == 's' && sBall_index < MAX_SMALL_BALLS)
 		{
 			sBall[sBall_index].size = BALL_SIZE / 2;
 			sBall[sBall_index].box = (Rectangle){ball->box.x, ball->box.y, sBall[sBall_index].size, sBall[sBall_index].size};
@@ -543,6 +593,7 @@ void updateSprite(Character * character);
 
 		// Setup the backbuffer for drawing (clear color and depth buffers)
 		ClearBackground(BLACK);
+		DrawTexture(background, 0, 0, WHITE);
 
 		// draw some text using the default font
 
@@ -567,15 +618,37 @@ void updateSprite(Character * character);
 
 		for (int i = 0; i <= MAX_BALLS; i++)
 		{
-			DrawRectangleRec(ball[i].box, ball[i].color);
+			DrawTexturePro(ballTexture, (Rectangle){0, 0, ballTexture.width, ballTexture.height}, ball[i].box, (Vector2){0, 0}, 0.0f, ball[i].color);
 		}
 		for (int i = 0; i <= MAX_BALLS * 2; i++)
 		{
-			DrawRectangleRec(sBall[i].box, sBall[i].color);
+			DrawTexturePro(ballTexture, (Rectangle){0, 0, ballTexture.width, ballTexture.height}, sBall[i].box, (Vector2){0, 0}, 0.0f, sBall[i].color);
+		}
+
+		if (showMemoryStats)
+		{
+			MemFrameStats stats = GetGameMemoryFrameStats();
+			DrawText(MemArenaFormat(&frameArena, "heap allocs: %d (%zu bytes)  frees: %d  clean frames: %d",
+									stats.allocCount, stats.allocBytes, stats.freeCount, stats.cleanFrames),
+					 25, 25, 20, RAYWHITE);
+			DrawText(MemArenaFormat(&frameArena, "level arena: %zu/%zu bytes  frame arena peak: %zu bytes",
+									levelArena.offset, levelArena.capacity, frameArena.peak),
+					 25, 50, 20, RAYWHITE);
+		}
+
+		// grab the finished scene before the recording indicator goes on top
+		UpdateCapture();
+		if (IsCapturing() && ((int)(GetTime() / 0.5) % 2 == 1))
+		{
+			DrawCircle(30, screenHeight - 20, 10, MAROON);
+			DrawText("REC", 50, screenHeight - 25, 10, RED);
 		}
 
 		// end the frame and get ready for the next one  (display frame, poll input, etc...)
 		EndDrawing();
+
+		// frame scratch is dead once the frame is presented
+		GameMemoryEndFrame();
 	}
 
 	// Init a sprite - pass in a &refrence for the character and will init the sprite
@@ -614,13 +687,48 @@ void updateSprite(Character * character);
 		character->sprite.frameRec.y = character->sprite.frameHeight * character->sprite.currentLine;
 	}
 
+	// Background and ball textures for the current level
+	// First load of a theme generates the images, later loads come straight from the procgen disk cache
+	void LoadLevelTextures(void)
+	{
+		int theme = level % NUM_LEVEL_THEMES;
+
+		ProcGenParams backgroundParams = levelBackgrounds[theme];
+		backgroundParams.width = screenWidth;
+		backgroundParams.height = screenHeight;
+
+		// white-ish cells, tinted per ball when drawn
+		ProcGenParams ballParams = {.type = PROCGEN_CELLULAR, .width = BALL_SIZE, .height = BALL_SIZE,
+									.colorA = {255, 255, 255, 255}, .colorB = {90, 90, 90, 255}, .seed = theme, .cellSize = BALL_SIZE / 3};
+
+		if (background.id > 0)
+			UnloadTexture(background);
+		if (ballTexture.id > 0)
+			UnloadTexture(ballTexture);
+
+		Image image = GenProcImage(backgroundParams);
+		background = LoadTextureFromImage(image);
+		UnloadImage(image);
+
+		image = GenProcImage(ballParams);
+		ballTexture = LoadTextureFromImage(image);
+		UnloadImage(image);
+	}
+
 	// UnloadGame - Final Cleanup
 	void UnloadGame(void)
 	{
 		UnloadTexture(endWabbit.texture);
 		UnloadTexture(chungus.texture);
 		UnloadTexture(projectile.texture);
+		UnloadTexture(background);
+		UnloadTexture(ballTexture);
+
+		StopCapture(); // needs the GL context
 
 		// destory the window and cleanup the OpenGL context
 		CloseWindow();
+
+		GameMemoryReport();
+		UnloadGameMemory();
 	}
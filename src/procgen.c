@@ -0,0 +1,503 @@
+#include "procgen.h"
+#include "game_thread.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <direct.h> // _mkdir
+#define MAKE_DIR(path) _mkdir(path)
+#else
+#include <sys/stat.h>
+#define MAKE_DIR(path) mkdir(path, 0755)
+#endif
+
+// Defines -------------------
+#define PROCGEN_CACHE_DIR "procgen_cache"
+#define PROCGEN_CACHE_MAGIC 0x43475057 // "WPGC"
+
+typedef struct ProcGenCacheHeader
+{
+	unsigned int magic;
+	unsigned int version;
+	int width;
+	int height;
+	unsigned long long key;
+} ProcGenCacheHeader; // followed by width*height RGBA8 pixels, top-down
+
+typedef struct ProcGenJob
+{
+	ProcGenParams params;
+	Color *pixels;
+	int perm[512]; // perlin permutation, repeated twice so lookups never wrap
+	int tileCount;
+	int nextTile;
+	GameMutex *mutex; // guards nextTile, NULL when running single threaded
+} ProcGenJob;
+
+// Scratch owned by one worker, rows are processed as flat float arrays so the inner loops vectorize
+typedef struct ProcGenScratch
+{
+	float *row;		// width values in 0..1
+	float *pointsX; // cellular: feature points of the 3 cell rows around the current row
+	float *pointsY;
+	int cellsAcross;
+} ProcGenScratch;
+
+// 8 gradient directions for 2D noise
+static const float gradX[8] = {1.0f, -1.0f, 1.0f, -1.0f, 1.0f, -1.0f, 0.0f, 0.0f};
+static const float gradY[8] = {1.0f, 1.0f, -1.0f, -1.0f, 0.0f, 0.0f, 1.0f, -1.0f};
+
+//------------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------------
+
+static float Clamp01(float value)
+{
+	return (value < 0.0f) ? 0.0f : ((value > 1.0f) ? 1.0f : value);
+}
+
+static float NoiseFade(float t)
+{
+	return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);
+}
+
+// Integer hash, deterministic across platforms (GetRandomValue() is neither seeded per image nor thread safe)
+static unsigned int Hash(unsigned int x)
+{
+	x ^= x >> 16;
+	x *= 0x7feb352du;
+	x ^= x >> 15;
+	x *= 0x846ca68bu;
+	x ^= x >> 16;
+	return x;
+}
+
+static unsigned int HashCell(int cellX, int cellY, int seed)
+{
+	return Hash((unsigned int)cellX * 0x9e3779b1u ^ Hash((unsigned int)cellY + (unsigned int)seed * 0x85ebca6bu));
+}
+
+static void InitPermutation(int *perm, int seed)
+{
+	for (int i = 0; i < 256; i++)
+		perm[i] = i;
+
+	unsigned int state = (unsigned int)seed;
+	for (int i = 255; i > 0; i--)
+	{
+		state = Hash(state + (unsigned int)i);
+		int j = (int)(state % (unsigned int)(i + 1));
+		int swap = perm[i];
+		perm[i] = perm[j];
+		perm[j] = swap;
+	}
+
+	for (int i = 0; i < 256; i++)
+		perm[256 + i] = perm[i];
+}
+
+//------------------------------------------------------------------------------------
+// Row generators - fill scratch->row with 0..1 for image row y
+//------------------------------------------------------------------------------------
+
+static void FillRowLinear(const ProcGenParams *params, int y, ProcGenScratch *scratch)
+{
+	float dirX = cosf(params->direction * DEG2RAD);
+	float dirY = sinf(params->direction * DEG2RAD);
+	float halfExtent = 0.5f * (fabsf(params->width * dirX) + fabsf(params->height * dirY));
+	float rowOffset = (y - params->height * 0.5f) * dirY;
+
+	for (int x = 0; x < params->width; x++)
+		scratch->row[x] = Clamp01(0.5f + 0.5f * ((x - params->width * 0.5f) * dirX + rowOffset) / halfExtent);
+}
+
+static void FillRowRadial(const ProcGenParams *params, int y, ProcGenScratch *scratch)
+{
+	float radius = 0.5f * (float)((params->width < params->height) ? params->width : params->height);
+	float inner = Clamp01(params->scale) * radius;
+	float invFalloff = (radius > inner) ? 1.0f / (radius - inner) : 0.0f;
+	float dy = y - params->height * 0.5f;
+
+	for (int x = 0; x < params->width; x++)
+	{
+		float dx = x - params->width * 0.5f;
+		scratch->row[x] = Clamp01((sqrtf(dx * dx + dy * dy) - inner) * invFalloff);
+	}
+}
+
+// One octave of 2D gradient noise added into row
+// The row is walked one lattice cell at a time: perm lookups and gradients are resolved once per span,
+// so the per-pixel loop is straight arithmetic on tx
+static void NoiseRow(const int *perm, float *row, int width, float y, float frequency, float amplitude)
+{
+	float fy = y * frequency;
+	float floorY = floorf(fy);
+	int iy = (int)floorY & 255;
+	float ty = fy - floorY;
+	float v = NoiseFade(ty);
+
+	int x = 0;
+	while (x < width)
+	{
+		float cellX = floorf((float)x * frequency);
+		int ix = (int)cellX & 255;
+		int spanEnd = (int)ceilf((cellX + 1.0f) / frequency);
+		if (spanEnd <= x)
+			spanEnd = x + 1; // rounding at a cell edge, always make progress
+		if (spanEnd > width)
+			spanEnd = width;
+
+		int a = perm[ix] + iy;
+		int b = perm[ix + 1] + iy;
+		int g00 = perm[a] & 7;
+		int g01 = perm[a + 1] & 7;
+		int g10 = perm[b] & 7;
+		int g11 = perm[b + 1] & 7;
+
+		float gx00 = gradX[g00], gx10 = gradX[g10], gx01 = gradX[g01], gx11 = gradX[g11];
+		float dy00 = gradY[g00] * ty;
+		float dy10 = gradY[g10] * ty;
+		float dy01 = gradY[g01] * (ty - 1.0f);
+		float dy11 = gradY[g11] * (ty - 1.0f);
+
+		for (int i = x; i < spanEnd; i++)
+		{
+			float tx = (float)i * frequency - cellX;
+			float u = NoiseFade(tx);
+
+			float n00 = gx00 * tx + dy00;
+			float n10 = gx10 * (tx - 1.0f) + dy10;
+			float n01 = gx01 * tx + dy01;
+			float n11 = gx11 * (tx - 1.0f) + dy11;
+
+			float nx0 = n00 + u * (n10 - n00);
+			float nx1 = n01 + u * (n11 - n01);
+			row[i] += amplitude * (nx0 + v * (nx1 - nx0));
+		}
+
+		x = spanEnd;
+	}
+}
+
+static void FillRowPerlin(const ProcGenJob *job, int y, ProcGenScratch *scratch)
+{
+	const ProcGenParams *params = &job->params;
+	int octaves = (params->octaves > 0) ? params->octaves : 1;
+	float frequency = params->scale / (float)params->width; // same meaning as GenImagePerlinNoise() scale
+	float amplitude = 1.0f;
+	float total = 0.0f;
+
+	memset(scratch->row, 0, params->width * sizeof(float));
+	for (int octave = 0; octave < octaves; octave++)
+	{
+		NoiseRow(job->perm, scratch->row, params->width, (float)y, frequency, amplitude);
+		total += amplitude;
+		frequency *= 2.0f;
+		amplitude *= 0.5f;
+	}
+
+	float normalize = 0.5f / total;
+	for (int x = 0; x < params->width; x++)
+		scratch->row[x] = Clamp01(0.5f + scratch->row[x] * normalize);
+}
+
+static void FillRowCellular(const ProcGenParams *params, int y, ProcGenScratch *scratch)
+{
+	int cellSize = (params->cellSize > 0) ? params->cellSize : 1;
+	int cellY = y / cellSize;
+
+	// feature points of the cell rows above, at and below y, one extra column on each side
+	for (int row = 0; row < 3; row++)
+	{
+		for (int column = 0; column < scratch->cellsAcross + 2; column++)
+		{
+			int cx = column - 1;
+			int cy = cellY + row - 1;
+			unsigned int hash = HashCell(cx, cy, params->seed);
+			scratch->pointsX[row * (scratch->cellsAcross + 2) + column] = (float)(cx * cellSize) + (float)(hash & 0xffff) * (cellSize / 65536.0f);
+			scratch->pointsY[row * (scratch->cellsAcross + 2) + column] = (float)(cy * cellSize) + (float)(hash >> 16) * (cellSize / 65536.0f);
+		}
+	}
+
+	// one cell column at a time: its 9 candidate points are fixed across the span
+	float invCellSize = 1.0f / (float)cellSize;
+	for (int column = 1; column <= scratch->cellsAcross; column++)
+	{
+		float candidateX[9];
+		float candidateDY2[9]; // vertical distance is constant along the row
+		for (int row = 0; row < 3; row++)
+		{
+			for (int i = 0; i < 3; i++)
+			{
+				int index = row * (scratch->cellsAcross + 2) + column - 1 + i;
+				float dy = scratch->pointsY[index] - (float)y;
+				candidateX[row * 3 + i] = scratch->pointsX[index];
+				candidateDY2[row * 3 + i] = dy * dy;
+			}
+		}
+
+		int spanStart = (column - 1) * cellSize;
+		int spanEnd = (spanStart + cellSize < params->width) ? spanStart + cellSize : params->width;
+
+		for (int x = spanStart; x < spanEnd; x++)
+		{
+			float nearest = 3.0e38f;
+			for (int i = 0; i < 9; i++)
+			{
+				float dx = candidateX[i] - (float)x;
+				float distance = dx * dx + candidateDY2[i];
+				nearest = (distance < nearest) ? distance : nearest;
+			}
+
+			scratch->row[x] = Clamp01(sqrtf(nearest) * invCellSize);
+		}
+	}
+}
+
+// row values to colors, colorA at 0 and colorB at 1
+static void ShadeRow(const float *row, Color *pixels, int width, Color colorA, Color colorB)
+{
+	float r = colorA.r, g = colorA.g, b = colorA.b, a = colorA.a;
+	float dr = (float)colorB.r - r, dg = (float)colorB.g - g, db = (float)colorB.b - b, da = (float)colorB.a - a;
+
+	for (int x = 0; x < width; x++)
+	{
+		float t = row[x];
+		pixels[x].r = (unsigned char)(r + t * dr + 0.5f);
+		pixels[x].g = (unsigned char)(g + t * dg + 0.5f);
+		pixels[x].b = (unsigned char)(b + t * db + 0.5f);
+		pixels[x].a = (unsigned char)(a + t * da + 0.5f);
+	}
+}
+
+//------------------------------------------------------------------------------------
+// Tile workers
+//------------------------------------------------------------------------------------
+
+static void ProcGenWorker(void *userData)
+{
+	ProcGenJob *job = (ProcGenJob *)userData;
+	const ProcGenParams *params = &job->params;
+
+	ProcGenScratch scratch = {0};
+	scratch.row = (float *)RL_MALLOC(params->width * sizeof(float));
+	if (params->type == PROCGEN_CELLULAR)
+	{
+		int cellSize = (params->cellSize > 0) ? params->cellSize : 1;
+		scratch.cellsAcross = (params->width + cellSize - 1) / cellSize;
+		scratch.pointsX = (float *)RL_MALLOC(3 * (scratch.cellsAcross + 2) * sizeof(float));
+		scratch.pointsY = (float *)RL_MALLOC(3 * (scratch.cellsAcross + 2) * sizeof(float));
+	}
+
+	bool ready = (scratch.row != NULL) && ((params->type != PROCGEN_CELLULAR) || (scratch.pointsX != NULL && scratch.pointsY != NULL));
+
+	while (ready)
+	{
+		if (job->mutex != NULL)
+			GameMutexLock(job->mutex);
+		int tile = job->nextTile++;
+		if (job->mutex != NULL)
+			GameMutexUnlock(job->mutex);
+
+		if (tile >= job->tileCount)
+			break;
+
+		int lastRow = (tile + 1) * PROCGEN_TILE_ROWS;
+		if (lastRow > params->height)
+			lastRow = params->height;
+
+		for (int y = tile * PROCGEN_TILE_ROWS; y < lastRow; y++)
+		{
+			switch (params->type)
+			{
+			case PROCGEN_GRADIENT_LINEAR: FillRowLinear(params, y, &scratch); break;
+			case PROCGEN_GRADIENT_RADIAL: FillRowRadial(params, y, &scratch); break;
+			case PROCGEN_PERLIN: FillRowPerlin(job, y, &scratch); break;
+			case PROCGEN_CELLULAR: FillRowCellular(params, y, &scratch); break;
+			}
+			ShadeRow(scratch.row, job->pixels + (size_t)y * params->width, params->width, params->colorA, params->colorB);
+		}
+	}
+
+	RL_FREE(scratch.row);
+	RL_FREE(scratch.pointsX);
+	RL_FREE(scratch.pointsY);
+}
+
+Image GenProcImageNoCache(ProcGenParams params)
+{
+	Image image = {0};
+	if (params.width <= 0 || params.height <= 0)
+		return image;
+
+	// job is ~2KB, keep it off the stack of whoever calls us
+	ProcGenJob *job = (ProcGenJob *)RL_CALLOC(1, sizeof(ProcGenJob));
+	Color *pixels = (Color *)RL_MALLOC((size_t)params.width * params.height * sizeof(Color));
+	if (job == NULL || pixels == NULL)
+	{
+		RL_FREE(job);
+		RL_FREE(pixels);
+		TraceLog(LOG_WARNING, "PROCGEN: Failed to allocate %ix%i image", params.width, params.height);
+		return image;
+	}
+
+	double startTime = GetTime();
+
+	job->params = params;
+	job->pixels = pixels;
+	job->tileCount = (params.height + PROCGEN_TILE_ROWS - 1) / PROCGEN_TILE_ROWS;
+	if (params.type == PROCGEN_PERLIN)
+		InitPermutation(job->perm, params.seed);
+
+	int threadCount = GameThreadCpuCount();
+	if (threadCount > PROCGEN_MAX_THREADS)
+		threadCount = PROCGEN_MAX_THREADS;
+	if (threadCount > job->tileCount)
+		threadCount = job->tileCount;
+	if (threadCount > 1)
+		job->mutex = GameMutexCreate();
+
+	// the calling thread works too, spawned helpers just pull tiles until none are left
+	GameThread *helpers[PROCGEN_MAX_THREADS] = {0};
+	if (job->mutex != NULL)
+	{
+		for (int i = 0; i < threadCount - 1; i++)
+			helpers[i] = GameThreadCreate(ProcGenWorker, job);
+	}
+	ProcGenWorker(job);
+	for (int i = 0; i < PROCGEN_MAX_THREADS; i++)
+		GameThreadJoin(helpers[i]);
+
+	if (job->mutex == NULL)
+		threadCount = 1;
+	GameMutexDestroy(job->mutex);
+	RL_FREE(job);
+
+	image.data = pixels;
+	image.width = params.width;
+	image.height = params.height;
+	image.mipmaps = 1;
+	image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+
+	TraceLog(LOG_INFO, "PROCGEN: Generated %ix%i image (type %i) in %.1f ms, %i threads",
+			 params.width, params.height, params.type, (GetTime() - startTime) * 1000.0, threadCount);
+	return image;
+}
+
+//------------------------------------------------------------------------------------
+// Disk cache
+//------------------------------------------------------------------------------------
+
+static unsigned long long HashBytes(unsigned long long hash, const void *data, size_t size)
+{
+	const unsigned char *bytes = (const unsigned char *)data;
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001b3ull; // FNV-1a
+	}
+	return hash;
+}
+
+// Field by field, struct padding is not guaranteed to be zeroed
+static unsigned long long HashParams(const ProcGenParams *params)
+{
+	unsigned long long hash = 0xcbf29ce484222325ull;
+	int version = PROCGEN_VERSION;
+	int type = (int)params->type;
+
+	hash = HashBytes(hash, &version, sizeof(version));
+	hash = HashBytes(hash, &type, sizeof(type));
+	hash = HashBytes(hash, &params->width, sizeof(params->width));
+	hash = HashBytes(hash, &params->height, sizeof(params->height));
+	hash = HashBytes(hash, &params->colorA, sizeof(params->colorA));
+	hash = HashBytes(hash, &params->colorB, sizeof(params->colorB));
+	hash = HashBytes(hash, &params->seed, sizeof(params->seed));
+	hash = HashBytes(hash, &params->scale, sizeof(params->scale));
+	hash = HashBytes(hash, &params->direction, sizeof(params->direction));
+	hash = HashBytes(hash, &params->octaves, sizeof(params->octaves));
+	hash = HashBytes(hash, &params->cellSize, sizeof(params->cellSize));
+	return hash;
+}
+
+static Image LoadCachedImage(const char *fileName, unsigned long long key, int width, int height)
+{
+	Image image = {0};
+	FILE *file = fopen(fileName, "rb");
+	if (file == NULL)
+		return image;
+
+	ProcGenCacheHeader header = {0};
+	size_t size = (size_t)width * height * sizeof(Color);
+
+	if (fread(&header, sizeof(header), 1, file) == 1 && header.magic == PROCGEN_CACHE_MAGIC &&
+		header.version == PROCGEN_VERSION && header.key == key && header.width == width && header.height == height)
+	{
+		image.data = RL_MALLOC(size);
+		if (image.data != NULL && fread(image.data, 1, size, file) == size)
+		{
+			image.width = width;
+			image.height = height;
+			image.mipmaps = 1;
+			image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+		}
+		else
+		{
+			RL_FREE(image.data); // truncated file, regenerate
+			image.data = NULL;
+		}
+	}
+
+	fclose(file);
+	return image;
+}
+
+static void SaveCachedImage(const char *fileName, unsigned long long key, Image image)
+{
+	MAKE_DIR(TextFormat("%s%s", GetApplicationDirectory(), PROCGEN_CACHE_DIR)); // fails harmlessly when it exists
+
+	// write next to the target and rename, so a crash never leaves a half written entry behind
+	char tempName[600];
+	snprintf(tempName, sizeof(tempName), "%s.tmp", fileName);
+
+	FILE *file = fopen(tempName, "wb");
+	if (file == NULL)
+	{
+		TraceLog(LOG_WARNING, "PROCGEN: Failed to write cache file %s", tempName);
+		return;
+	}
+
+	ProcGenCacheHeader header = {PROCGEN_CACHE_MAGIC, PROCGEN_VERSION, image.width, image.height, key};
+	size_t size = (size_t)image.width * image.height * sizeof(Color);
+	bool written = (fwrite(&header, sizeof(header), 1, file) == 1) && (fwrite(image.data, 1, size, file) == size);
+	fclose(file);
+
+	remove(fileName);
+	if (!written || rename(tempName, fileName) != 0)
+	{
+		remove(tempName);
+		TraceLog(LOG_WARNING, "PROCGEN: Failed to write cache file %s", fileName);
+	}
+}
+
+Image GenProcImage(ProcGenParams params)
+{
+	unsigned long long key = HashParams(&params);
+
+	char fileName[512];
+	snprintf(fileName, sizeof(fileName), "%s%s/%016llx.pgc", GetApplicationDirectory(), PROCGEN_CACHE_DIR, key);
+
+	Image image = LoadCachedImage(fileName, key, params.width, params.height);
+	if (image.data != NULL)
+	{
+		TraceLog(LOG_INFO, "PROCGEN: Loaded %ix%i image from cache %016llx", params.width, params.height, key);
+		return image;
+	}
+
+	image = GenProcImageNoCache(params);
+	if (image.data != NULL)
+		SaveCachedImage(fileName, key, image);
+
+	return image;
+}
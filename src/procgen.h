@@ -0,0 +1,39 @@
+// procgen.h - procedural images (noise, gradients, cells) generated in parallel and cached on disk
+//
+// Replaces raylib's GenImage* helpers for level assets: those are single threaded and take seconds
+// at full screen size. Images are split into row tiles shared between worker threads, and every
+// result is stored under procgen_cache/ next to the executable, keyed by a hash of its parameters,
+// so a level that was loaded before skips generation entirely.
+
+#pragma once
+
+#include "raylib.h"
+
+#define PROCGEN_VERSION 2		// bump when an algorithm changes, invalidates the disk cache
+#define PROCGEN_TILE_ROWS 32	// rows per work item
+#define PROCGEN_MAX_THREADS 16
+
+typedef enum ProcGenType
+{
+	PROCGEN_GRADIENT_LINEAR = 0, // colorA -> colorB along direction
+	PROCGEN_GRADIENT_RADIAL,	 // colorA in the centre -> colorB at the edge
+	PROCGEN_PERLIN,				 // fBm gradient noise, colorA at -1, colorB at 1
+	PROCGEN_CELLULAR			 // distance to the nearest cell point, colorA at the point, colorB a cell away
+} ProcGenType;
+
+typedef struct ProcGenParams
+{
+	ProcGenType type;
+	int width;
+	int height;
+	Color colorA;
+	Color colorB;
+	int seed;		 // perlin, cellular
+	float scale;	 // perlin: features across the image width, radial: inner solid fraction (0..1)
+	float direction; // linear: degrees, 0 = left to right, 90 = top to bottom
+	int octaves;	 // perlin
+	int cellSize;	 // cellular: pixels per cell
+} ProcGenParams;
+
+Image GenProcImage(ProcGenParams params);	 // load from the disk cache or generate and store, unload with UnloadImage()
+Image GenProcImageNoCache(ProcGenParams params); // always generate
@@ -0,0 +1,38 @@
+// rl_alloc_hooks.h - routes raylib's RL_MALLOC/RL_CALLOC/RL_REALLOC/RL_FREE through the game allocator
+//
+// Force-included (-include) into both the raylib and game builds, see build/premake5.lua.
+// raylib.h and rlgl.h only define their allocator macros when they are not already defined,
+// so every raylib allocation (and the stb/qoi/msf_gif/miniaudio ones remapped onto RL_MALLOC)
+// ends up in GameMemAlloc() tagged with the call site.
+//
+// Keep this header free of raylib includes - it is seen before raylib.h in every translation unit.
+
+#pragma once
+
+#include <stddef.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+void *GameMemAlloc(size_t size, const char *file, int line);
+void *GameMemCalloc(size_t count, size_t size, const char *file, int line);
+void *GameMemRealloc(void *ptr, size_t size, const char *file, int line);
+void GameMemFree(void *ptr, const char *file, int line);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#ifndef RL_MALLOC
+	#define RL_MALLOC(sz)       GameMemAlloc((sz), __FILE__, __LINE__)
+#endif
+#ifndef RL_CALLOC
+	#define RL_CALLOC(n,sz)     GameMemCalloc((n), (sz), __FILE__, __LINE__)
+#endif
+#ifndef RL_REALLOC
+	#define RL_REALLOC(ptr,sz)  GameMemRealloc((ptr), (sz), __FILE__, __LINE__)
+#endif
+#ifndef RL_FREE
+	#define RL_FREE(ptr)        GameMemFree((ptr), __FILE__, __LINE__)
+#endif